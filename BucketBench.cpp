@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "HashMap.hpp"
+
+/**   Number of keys in every run        */
+const int NUM_OF_KEYS = 1 << 16;
+/**   Shift of the structured integer keys (multiples of a power of two)        */
+const int KEY_SHIFT = 12;
+/**   Number of lookups rounds        */
+const int LOOKUP_ROUNDS = 8;
+/**   Longest bucket length with its own histogram bin (longer ones share the last bin)        */
+const int MAX_HISTOGRAM_LEN = 8;
+
+
+/**
+ * @brief Fills a map with the given keys, looks all of them up and prints the bucket length
+ *        distribution (by bucketSize) and the time it took
+ * @tparam Map The map type
+ * @tparam KeyT The key type
+ * @param name Name of the run
+ * @param map Empty map to fill
+ * @param keys The keys to insert
+ */
+template<class Map, class KeyT>
+void bench(const std::string & name, Map map, const std::vector<KeyT> & keys)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        map.insert(keys[i], (int) i);
+    }
+    long found = 0;
+    for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+    {
+        for (auto & key : keys)
+        {
+            found += map.containsKey(key);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    long total = 0;
+    int max = 0;
+    std::vector<int> histogram(MAX_HISTOGRAM_LEN + 2);
+    for (auto & key : keys)
+    {
+        int len = map.bucketSize(key);
+        total += len;
+        max = std::max(max, len);
+        ++histogram[std::min(len, MAX_HISTOGRAM_LEN + 1)];
+    }
+
+    std::cout << name << ": capacity " << map.capacity() << ", found " << found
+              << ", mean bucket " << (double) total / keys.size() << ", max bucket " << max
+              << ", time " << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms" << std::endl << "    buckets:";
+    for (int len = 1; len <= MAX_HISTOGRAM_LEN; ++len)
+    {
+        std::cout << " [" << len << "]=" << histogram[len];
+    }
+    std::cout << " [>" << MAX_HISTOGRAM_LEN << "]=" << histogram[MAX_HISTOGRAM_LEN + 1]
+              << std::endl;
+}
+
+/**
+ * @brief Compares std::hash with the bundled FastHash, on both storages
+ * @return 0
+ */
+int main()
+{
+    std::vector<int> intKeys;
+    std::vector<std::string> strKeys;
+    for (int i = 0; i < NUM_OF_KEYS; ++i)
+    {
+        intKeys.push_back(i << KEY_SHIFT);
+        strKeys.push_back("suspicious phrase number " + std::to_string(i));
+    }
+
+    using IntStd = std::hash<int>;
+    using IntFast = FastHash<int>;
+    using IntEq = std::equal_to<int>;
+    bench("generic int, std::hash", HashMap<int, int, IntStd, IntEq, false>(), intKeys);
+    bench("generic int, FastHash", HashMap<int, int, IntFast, IntEq, false>(), intKeys);
+    bench("flat int, std::hash", HashMap<int, int, IntStd>(), intKeys);
+    bench("flat int, FastHash", HashMap<int, int>(), intKeys);
+    bench("flat int, seeded FastHash", HashMap<int, int>(IntFast(randomHashSeed())), intKeys);
+
+    bench("string, std::hash", HashMap<std::string, int, std::hash<std::string>>(), strKeys);
+    bench("string, FastHash", HashMap<std::string, int>(), strKeys);
+    return 0;
+}
@@ -5,30 +5,340 @@
 #include <vector>
 #include <stdexcept>
 #include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
 
 /**  Minimum capacity on the map  */
-const int MIN_CAPACITY = 1;
+constexpr int MIN_CAPACITY = 1;
 
 /**  Default values  */
-const double DEF_LOW_FACTOR = 0.25;
-const double DEF_HIGH_FACTOR = 0.75;
-const int DEF_SIZE = 0;
-const int DEF_CAPACITY = 16;
+constexpr double DEF_LOW_FACTOR = 0.25;
+constexpr double DEF_HIGH_FACTOR = 0.75;
+constexpr int DEF_SIZE = 0;
+constexpr int DEF_CAPACITY = 16;
 
 /**  Table resizing parameter  */
-const int RESIZE_PARM = 2;
+constexpr int RESIZE_PARM = 2;
 
 /** Default iterator values  */
 const int INIT_TABLA_INDEX = 0;
 const int INIT_LIST_INDEX = -1;
 
 
+/**
+ * @brief Integer finalizer (splitmix64) - spreads every input bit over the whole word, so that
+ *        masking with (capacity - 1) does not depend only on the low bits of the key
+ * @param x Value to mix
+ * @return The mixed value
+ */
+inline std::size_t mixBits(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return (std::size_t) x;
+}
+
+/**  wyhash default secret  */
+const std::uint64_t WY_SECRET[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+                                    0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+/**
+ * @brief Full 64x64 -> 128 bit multiplication
+ * @param a First factor, replaced by the low half of the product
+ * @param b Second factor, replaced by the high half of the product
+ */
+inline void wyMum(std::uint64_t & a, std::uint64_t & b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = a;
+    r *= b;
+    a = (std::uint64_t) r;
+    b = (std::uint64_t) (r >> 64);
+#else
+    std::uint64_t ha = a >> 32, hb = b >> 32, la = (std::uint32_t) a, lb = (std::uint32_t) b;
+    std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    std::uint64_t t = rl + (rm0 << 32), c = t < rl;
+    std::uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/**
+ * @brief Multiply and fold the two halves of the product
+ * @param a First factor
+ * @param b Second factor
+ * @return The mixed value
+ */
+inline std::uint64_t wyMix(std::uint64_t a, std::uint64_t b)
+{
+    wyMum(a, b);
+    return a ^ b;
+}
+
+/**
+ * @brief Unaligned read of 8 bytes
+ * @param p Pointer to the bytes
+ * @return The bytes as a number
+ */
+inline std::uint64_t wyRead8(const unsigned char *p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Unaligned read of 4 bytes
+ * @param p Pointer to the bytes
+ * @return The bytes as a number
+ */
+inline std::uint64_t wyRead4(const unsigned char *p)
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Read of 1 to 3 bytes - the first, the middle and the last one
+ * @param p Pointer to the bytes
+ * @param k Number of bytes (1 to 3)
+ * @return The bytes as a number
+ */
+inline std::uint64_t wyRead3(const unsigned char *p, std::size_t k)
+{
+    return (((std::uint64_t) p[0]) << 16) | (((std::uint64_t) p[k >> 1]) << 8) | p[k - 1];
+}
+
+/**
+ * @brief wyhash (final version 4) of a bytes sequence
+ * @param key Pointer to the bytes
+ * @param len Number of bytes
+ * @param seed Hash seed
+ * @return The hash value
+ */
+inline std::uint64_t wyHash(const void *key, std::size_t len, std::uint64_t seed)
+{
+    const unsigned char *p = (const unsigned char *) key;
+    const std::uint64_t *secret = WY_SECRET;
+    seed ^= wyMix(seed ^ secret[0], secret[1]);
+    std::uint64_t a, b;
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            a = (wyRead4(p) << 32) | wyRead4(p + ((len >> 3) << 2));
+            b = (wyRead4(p + len - 4) << 32) | wyRead4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0)
+        {
+            a = wyRead3(p, len);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        std::size_t i = len;
+        if (i > 48)
+        {
+            std::uint64_t see1 = seed, see2 = seed;
+            do
+            {
+                seed = wyMix(wyRead8(p) ^ secret[1], wyRead8(p + 8) ^ seed);
+                see1 = wyMix(wyRead8(p + 16) ^ secret[2], wyRead8(p + 24) ^ see1);
+                see2 = wyMix(wyRead8(p + 32) ^ secret[3], wyRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = wyMix(wyRead8(p) ^ secret[1], wyRead8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wyRead8(p + i - 16);
+        b = wyRead8(p + i - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    wyMum(a, b);
+    return wyMix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+/**
+ * @brief A function that returns a random seed, for maps that should not be predictable
+ * @return random seed
+ */
+inline std::uint64_t randomHashSeed()
+{
+    std::random_device rd;
+    return (((std::uint64_t) rd()) << 32) ^ rd();
+}
+
+/**
+ * @brief The default hash of the map - the result of std::hash passed through the integer
+ *        finalizer, since std::hash of integers is the identity
+ * @tparam KeyT The key type
+ */
+template<class KeyT>
+class FastHash
+{
+private:
+    /**   The seed of this hash         */
+    std::uint64_t _seed;
+
+public:
+    /**
+     * @brief constructor
+     * @param seed The seed of this hash
+     */
+    explicit FastHash(std::uint64_t seed = 0) : _seed(seed)
+    {}
+
+    /**
+     * @brief Hash operator
+     * @param key Key to hash
+     * @return The hash value
+     */
+    std::size_t operator()(const KeyT & key) const
+    {
+        return mixBits(((std::uint64_t) std::hash<KeyT>()(key)) ^ _seed);
+    }
+};
+
+/**
+ * @brief The default hash of strings - wyhash
+ */
+template<>
+class FastHash<std::string>
+{
+private:
+    /**   The seed of this hash         */
+    std::uint64_t _seed;
+
+public:
+    /**
+     * @brief constructor
+     * @param seed The seed of this hash
+     */
+    explicit FastHash(std::uint64_t seed = 0) : _seed(seed)
+    {}
+
+    /**
+     * @brief Hash operator
+     * @param key Key to hash
+     * @return The hash value
+     */
+    std::size_t operator()(const std::string & key) const
+    {
+        return (std::size_t) wyHash(key.data(), key.size(), _seed);
+    }
+};
+
+/**
+ * @brief Heap bytes owned by a key or a value (none, unless specialized)
+ * @tparam T The key or value type
+ */
+template<class T>
+struct HeapBytes
+{
+    /**
+     * @brief Heap bytes operator
+     * @return number of heap bytes owned by the object
+     */
+    std::size_t operator()(const T &) const
+    {
+        return 0;
+    }
+};
+
+/**
+ * @brief Heap bytes owned by a string - none while it is in its inline (SSO) buffer
+ */
+template<>
+struct HeapBytes<std::string>
+{
+    /**
+     * @brief Heap bytes operator
+     * @param str The string
+     * @return number of heap bytes owned by the string
+     */
+    std::size_t operator()(const std::string & str) const
+    {
+        return str.capacity() > std::string().capacity() ? str.capacity() + 1 : 0;
+    }
+};
+
+/**
+ * @brief The memory used by a map, in bytes
+ */
+struct MemoryUsage
+{
+    /**   The map object and its table array         */
+    std::size_t table;
+    /**   The heap storage of the buckets         */
+    std::size_t buckets;
+    /**   The heap storage owned by the keys         */
+    std::size_t keys;
+    /**   The heap storage owned by the values         */
+    std::size_t values;
+
+    /**
+     * @brief A function that returns the total memory
+     * @return the total memory, in bytes
+     */
+    std::size_t total() const
+    {
+        return table + buckets + keys + values;
+    }
+};
+
+/**
+ * @brief Compile time selection of the flat (open addressing) storage - used for integral keys
+ *        with trivially copyable values, which can be kept inline in a single array. Only integral
+ *        keys have a natural empty slot sentinel (numeric_limits max), and it is found with ==,
+ *        so other keys and a custom key comparison keep the generic storage.
+ * @tparam KeyT The key type
+ * @tparam ValueT The value type
+ * @tparam KeyEqual The keys comparison
+ */
+template<class KeyT, class ValueT, class KeyEqual = std::equal_to<KeyT>>
+struct UseFlatStorage : std::integral_constant<bool,
+        std::is_integral<KeyT>::value &&
+        std::is_trivially_copyable<ValueT>::value &&
+        std::is_default_constructible<ValueT>::value &&
+        std::is_same<KeyEqual, std::equal_to<KeyT>>::value>
+{
+};
+
 /**
  * @brief An object that is a map data structure, by an open hash table
  * @tparam KeyT The key type
  * @tparam ValueT The value type
+ * @tparam Hash The keys hash function
+ * @tparam KeyEqual The keys comparison
+ * @tparam Flat Whether to use the flat storage (specialized below)
  */
-template<class KeyT, class ValueT>
+template<class KeyT, class ValueT, class Hash = FastHash<KeyT>,
+        class KeyEqual = std::equal_to<KeyT>,
+        bool Flat = UseFlatStorage<KeyT, ValueT, KeyEqual>::value>
 class HashMap
 {
     using pairs = std::pair<KeyT, ValueT>;
@@ -42,10 +352,64 @@ private:
     double _lowLoadFactor;
     /**   high Load Factor bar          */
     double _highLoadFactor;
-    /**   The current data table         */
+    /**   The current data table (nullptr while the map is compact)         */
     std::vector<pairs> *_table;
     /**    tha use Hash function        */
-    std::hash<KeyT> _hashFanc;
+    Hash _hashFanc;
+    /**    tha use keys comparison        */
+    KeyEqual _keyEqual;
+    /**   The compact table - all the pairs in one array, ordered by bucket         */
+    std::vector<pairs> _compact;
+    /**   Where every bucket starts in the compact table (capacity + 1 offsets)         */
+    std::vector<int> _offsets;
+
+    /**
+     * @brief A function that returns the number of pairs in a bucket
+     * @param i Table index
+     * @return the bucket size
+     */
+    int _bucketLen(int i) const
+    {
+        return _table != nullptr ? (int) _table[i].size() : _offsets[i + 1] - _offsets[i];
+    }
+
+    /**
+     * @brief A function that returns a pair of a bucket
+     * @param i Table index
+     * @param j Index in the bucket
+     * @return Reference to the pair
+     */
+    const pairs & _pairAt(int i, int j) const
+    {
+        return _table != nullptr ? _table[i][j] : _compact[_offsets[i] + j];
+    }
+
+    /**
+     * @brief A function that frees the compact table
+     */
+    void _releaseCompact()
+    {
+        std::vector<pairs>().swap(_compact);
+        std::vector<int>().swap(_offsets);
+    }
+
+    /**
+     * @brief A function that returns a compact map to the vectors table, before it is changed
+     */
+    void _expand()
+    {
+        if (_table != nullptr)
+        {
+            return;
+        }
+        auto newTable = new std::vector<pairs>[_capacity];
+        for (int i = 0; i < _capacity; ++i)
+        {
+            newTable[i].assign(_compact.begin() + _offsets[i], _compact.begin() + _offsets[i + 1]);
+        }
+        _table = newTable;
+        _releaseCompact();
+    }
 
     /**
      * @brief A function that resizes the table size
@@ -64,6 +428,7 @@ private:
         }
 
         delete[] _table;
+        _releaseCompact();
         _table = newTable;
         _capacity = newCap;
     }
@@ -90,12 +455,32 @@ public:
      * @param lowFactor Low Load Factor bar
      * @param higeFactor high Load Factor bar
      */
-    HashMap(double lowFactor, double higeFactor) :
+    HashMap(double lowFactor, double higeFactor) : HashMap(lowFactor, higeFactor, Hash())
+    {}
+
+    /**
+     * @brief constructor with a given hash (for example a seeded one)
+     * @param hash The keys hash function
+     */
+    explicit HashMap(const Hash & hash) : HashMap(DEF_LOW_FACTOR, DEF_HIGH_FACTOR, hash)
+    {}
+
+    /**
+     * @brief constructor
+     * @param lowFactor Low Load Factor bar
+     * @param higeFactor high Load Factor bar
+     * @param hash The keys hash function
+     * @param keyEqual The keys comparison
+     */
+    HashMap(double lowFactor, double higeFactor, const Hash & hash,
+            const KeyEqual & keyEqual = KeyEqual()) :
             _capacity(DEF_CAPACITY),
             _size(DEF_SIZE),
             _lowLoadFactor(lowFactor),
             _highLoadFactor(higeFactor),
-            _table(new std::vector<pairs>[_capacity])
+            _table(new std::vector<pairs>[_capacity]),
+            _hashFanc(hash),
+            _keyEqual(keyEqual)
     {
         // Input integrity check
         if (lowFactor <= 0 || lowFactor >= 1 ||
@@ -114,10 +499,9 @@ public:
      */
     HashMap(const std::vector<KeyT> & keyVec, const std::vector<ValueT> & valVec) : HashMap()
     {
-        // Check that the vectors are the same size
+        // Check that the vectors are the same size (the destructor frees the table)
         if (keyVec.size() != valVec.size())
         {
-            delete[] _table;
             throw std::invalid_argument("The resulting vectors are not the same size");
         }
 
@@ -136,9 +520,13 @@ public:
             _size(other._size),
             _lowLoadFactor(other._lowLoadFactor),
             _highLoadFactor(other._highLoadFactor),
-            _table(new std::vector<pairs>[other._capacity])
+            _table(other._table != nullptr ? new std::vector<pairs>[other._capacity] : nullptr),
+            _hashFanc(other._hashFanc),
+            _keyEqual(other._keyEqual),
+            _compact(other._compact),
+            _offsets(other._offsets)
     {
-        for (int i = 0; i < _capacity; ++i)
+        for (int i = 0; _table != nullptr && i < _capacity; ++i)
         {
             _table[i] = other._table[i];
         }
@@ -152,7 +540,11 @@ public:
             _capacity(other._capacity),
             _size(other._size),
             _lowLoadFactor(other._lowLoadFactor),
-            _highLoadFactor(other._highLoadFactor)
+            _highLoadFactor(other._highLoadFactor),
+            _hashFanc(other._hashFanc),
+            _keyEqual(other._keyEqual),
+            _compact(std::move(other._compact)),
+            _offsets(std::move(other._offsets))
     {
         _table = other._table;
         other._table = nullptr;
@@ -214,6 +606,7 @@ public:
         {
             return false;
         }
+        _expand();
         ++_size;
         if (getLoadFactor() > _highLoadFactor)
         {
@@ -230,9 +623,10 @@ public:
      */
     bool containsKey(const KeyT & key) const
     {
-        for (auto pair :  _table[_index(key)])
+        int index = _index(key);
+        for (int i = 0; i < _bucketLen(index); ++i)
         {
-            if (pair.first == key)
+            if (_keyEqual(_pairAt(index, i).first, key))
             {
                 return true;
             }
@@ -247,14 +641,7 @@ public:
      */
     ValueT & at(const KeyT & keyToSearch)
     {
-        for (size_t i = 0; i < _table[_index(keyToSearch)].size(); i++)
-        {
-            if (_table[_index(keyToSearch)].at(i).first == keyToSearch)
-            {
-                return _table[_index(keyToSearch)].at(i).second;
-            }
-        }
-        throw std::out_of_range("The key does not exist on the map");
+        return const_cast<ValueT &>(static_cast<const HashMap &>(*this).at(keyToSearch));
     }
 
     /**
@@ -264,11 +651,12 @@ public:
      */
     const ValueT & at(const KeyT & keyToSearch) const
     {
-        for (size_t i = 0; i < _table[_index(keyToSearch)].size(); i++)
+        int index = _index(keyToSearch);
+        for (int i = 0; i < _bucketLen(index); i++)
         {
-            if (_table[_index(keyToSearch)].at(i).first == keyToSearch)
+            if (_keyEqual(_pairAt(index, i).first, keyToSearch))
             {
-                return _table[_index(keyToSearch)].at(i).second;
+                return _pairAt(index, i).second;
             }
         }
         throw std::out_of_range("The key does not exist on the map");
@@ -281,10 +669,15 @@ public:
      */
     bool erase(const KeyT & ketToDel)
     {
+        if (!containsKey(ketToDel))
+        {
+            return false;
+        }
+        _expand();
         auto itr = _table[_index(ketToDel)].begin();
         while (itr != _table[_index(ketToDel)].end())
         {
-            if ((*itr).first == ketToDel)
+            if (_keyEqual((*itr).first, ketToDel))
             {
                 _table[_index(ketToDel)].erase(itr);
                 --_size;
@@ -311,7 +704,66 @@ public:
         {
             throw std::out_of_range("The key does not exist on the map");
         }
-        return _table[_index(key)].size();
+        return _bucketLen(_index(key));
+    }
+
+    /**
+     * @brief A function that returns the memory used by the map
+     * @return the memory used by the map
+     */
+    MemoryUsage memoryUsage() const
+    {
+        MemoryUsage usage = {sizeof(*this), 0, 0, 0};
+        if (_table != nullptr)
+        {
+            usage.table += _capacity * sizeof(std::vector<pairs>);
+            for (int i = 0; i < _capacity; ++i)
+            {
+                usage.buckets += _table[i].capacity() * sizeof(pairs);
+            }
+        }
+        else
+        {
+            usage.table += _offsets.capacity() * sizeof(int);
+            usage.buckets += _compact.capacity() * sizeof(pairs);
+        }
+        for (auto & pair : *this)
+        {
+            usage.keys += HeapBytes<KeyT>()(pair.first);
+            usage.values += HeapBytes<ValueT>()(pair.second);
+        }
+        return usage;
+    }
+
+    /**
+     * @brief A function that re-layouts the map for reading - the smallest table that keeps the
+     *        high load factor, with all the pairs (copied, so the keys are tight) in one array
+     *        ordered by bucket, and the offset of every bucket in it. The next insert or erase
+     *        returns the map to a table of vectors.
+     */
+    void shrinkToFit()
+    {
+        int newCap = MIN_CAPACITY;
+        while (size() > _highLoadFactor * newCap)
+        {
+            newCap *= RESIZE_PARM;
+        }
+        _reSize(newCap);
+
+        std::vector<pairs> compact;
+        std::vector<int> offsets(_capacity + 1);
+        compact.reserve(_size);
+        for (int i = 0; i < _capacity; ++i)
+        {
+            offsets[i] = (int) compact.size();
+            compact.insert(compact.end(), _table[i].begin(), _table[i].end());
+        }
+        offsets[_capacity] = (int) compact.size();
+
+        delete[] _table;
+        _table = nullptr;
+        _compact.swap(compact);
+        _offsets.swap(offsets);
     }
 
     /**
@@ -320,6 +772,7 @@ public:
     void clear()
     {
         delete[] _table;
+        _releaseCompact();
         _table = new std::vector<pairs>[_capacity];
         _size = 0;
     }
@@ -341,9 +794,13 @@ public:
         _size = other._size;
         _lowLoadFactor = other._lowLoadFactor;
         _highLoadFactor = other._highLoadFactor;
-        _table = new std::vector<pairs>[other._capacity];
+        _hashFanc = other._hashFanc;
+        _keyEqual = other._keyEqual;
+        _table = other._table != nullptr ? new std::vector<pairs>[other._capacity] : nullptr;
+        _compact = other._compact;
+        _offsets = other._offsets;
 
-        for (int i = 0; i < _capacity; ++i)
+        for (int i = 0; _table != nullptr && i < _capacity; ++i)
         {
             _table[i] = other._table[i];
         }
@@ -364,18 +821,11 @@ public:
     /**
      * @brief Operator Value Access by Key
      * @param key A key to accessing its value
-     * @return const Reference to the appropriate value
+     * @return const Reference to the appropriate value (out_of_range if the key is missing)
      */
     const ValueT & operator[](const KeyT & key) const
     {
-        for (auto & pair :  _table[_index(key)])
-        {
-            if (pair.first == key)
-            {
-                return pair.second;
-            }
-        }
-        return _table[_index(key)].at(0).second;
+        return at(key);
     }
 
     /**
@@ -423,7 +873,7 @@ public:
     {
     private:
         /**   Pointer to the map object          */
-        const HashMap<KeyT, ValueT> *_myMap;
+        const HashMap *_myMap;
         /**   The current table index      */
         int _tableIndex;
         /**   Current basket index      */
@@ -434,7 +884,7 @@ public:
          * @brief Default constructor - to start map
          * @param myMap Pointer to the map object
          */
-        explicit const_iterator(const HashMap<KeyT, ValueT> *myMap) :
+        explicit const_iterator(const HashMap *myMap) :
                 _myMap(myMap),
                 _tableIndex(INIT_TABLA_INDEX),
                 _listIndex(INIT_LIST_INDEX)
@@ -448,7 +898,7 @@ public:
          * @param listI Initial list index
          * @param myMap Pointer to the map object
          */
-        const_iterator(int tableI, int listI, const HashMap<KeyT, ValueT> *myMap) :
+        const_iterator(int tableI, int listI, const HashMap *myMap) :
                 _myMap(myMap),
                 _tableIndex(tableI),
                 _listIndex(listI)
@@ -460,7 +910,7 @@ public:
          */
         const std::pair<KeyT, ValueT> & operator*() const
         {
-            return _myMap->_table[_tableIndex].at(_listIndex);
+            return _myMap->_pairAt(_tableIndex, _listIndex);
         }
 
         /**
@@ -469,7 +919,7 @@ public:
          */
         const std::pair<KeyT, ValueT> *operator->() const
         {
-            return &_myMap->_table[_tableIndex].at(_listIndex);
+            return &_myMap->_pairAt(_tableIndex, _listIndex);
         }
 
         /**
@@ -478,20 +928,23 @@ public:
          */
         const_iterator & operator++()
         {
-            if ((long) _myMap->_table[_tableIndex].size() > ++_listIndex)
+            if (_tableIndex < _myMap->capacity() &&
+                _myMap->_bucketLen(_tableIndex) > ++_listIndex)
             {
                 return *this;
             }
 
             _listIndex = 0;
-            do
+            while (++_tableIndex < _myMap->capacity())
             {
-                ++_tableIndex;
-                if ((long) _myMap->_table[_tableIndex].size() > _listIndex)
+                if (_myMap->_bucketLen(_tableIndex) > _listIndex)
                 {
                     return *this;
                 }
-            } while (_tableIndex < _myMap->capacity());
+            }
+            // Reached the end - same indexes as end()
+            _tableIndex = _myMap->capacity();
+            _listIndex = INIT_LIST_INDEX;
             return *this;
         }
 
@@ -574,4 +1027,706 @@ public:
     }
 };
 
+/**
+ * @brief The map for integral keys and trivially copyable values - an open addressing table
+ *        (linear probing) that keeps the pairs inline in a single array. Empty slots are marked
+ *        by a sentinel key; the sentinel key itself is still a valid key and is kept aside.
+ * @tparam KeyT The key type
+ * @tparam ValueT The value type
+ * @tparam Hash The keys hash function
+ * @tparam KeyEqual The keys comparison (always std::equal_to)
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+class HashMap<KeyT, ValueT, Hash, KeyEqual, true>
+{
+    using pairs = std::pair<KeyT, ValueT>;
+    static_assert(std::is_same<KeyEqual, std::equal_to<KeyT>>::value,
+                  "The flat storage compares keys with ==, use Flat = false for another KeyEqual");
+
+private:
+    /**   Current table size         */
+    int _capacity;
+    /**   The current number of values in the map         */
+    int _size;
+    /**   Low Load Factor bar        */
+    double _lowLoadFactor;
+    /**   high Load Factor bar          */
+    double _highLoadFactor;
+    /**   Largest size that does not exceed the high load factor         */
+    int _growAt;
+    /**   Smallest size that does not fall below the low load factor         */
+    int _shrinkAt;
+    /**   The current slots table         */
+    pairs *_slots;
+    /**   Whether the sentinel key is on the map         */
+    bool _hasEmptyKey;
+    /**   The pair of the sentinel key, when it is on the map         */
+    pairs _emptyKeyPair;
+    /**    tha use Hash function        */
+    Hash _hashFanc;
+
+    /**
+     * @brief The key that marks an empty slot
+     * @return the sentinel key
+     */
+    static constexpr KeyT _emptyKey()
+    {
+        return std::numeric_limits<KeyT>::max();
+    }
+
+    /**
+     * @brief A function that updates the size bars according to the current capacity, so that
+     *        insert and erase compare integers only
+     */
+    void _updateBars()
+    {
+        _growAt = (int) std::floor(_highLoadFactor * _capacity);
+        _shrinkAt = (int) std::ceil(_lowLoadFactor * _capacity);
+    }
+
+    /**
+     * @brief A function that allocates a table of empty slots
+     * @param cap The table size
+     * @return The new table
+     */
+    static pairs *_newSlots(int cap)
+    {
+        auto slots = new pairs[cap];
+        for (int i = 0; i < cap; ++i)
+        {
+            slots[i].first = _emptyKey();
+        }
+        return slots;
+    }
+
+    /**
+     * @brief A function that resizes the table size
+     * @param newCap New table size
+     */
+    void _reSize(int newCap)
+    {
+        // At least one slot must stay empty, to stop the probing
+        if (newCap < MIN_CAPACITY || newCap <= _size - (int) _hasEmptyKey)
+        {
+            return;
+        }
+        auto newSlots = _newSlots(newCap);
+        for (int i = 0; i < _capacity; ++i)
+        {
+            if (_slots[i].first != _emptyKey())
+            {
+                int j = (int) (_hash(_slots[i].first) & (newCap - 1));
+                while (newSlots[j].first != _emptyKey())
+                {
+                    j = (j + 1) & (newCap - 1);
+                }
+                newSlots[j] = _slots[i];
+            }
+        }
+
+        delete[] _slots;
+        _slots = newSlots;
+        _capacity = newCap;
+        _updateBars();
+    }
+
+    /**
+     * @brief A function that hashes a key - a hash other than FastHash (which is already mixed) is
+     *        passed through mixBits, since identity hashes make linear probing run in long chains
+     * @param key Key to hash
+     * @return The hash value
+     */
+    std::size_t _hash(const KeyT & key) const
+    {
+        std::size_t hash = _hashFanc(key);
+        return std::is_same<Hash, FastHash<KeyT>>::value ? hash : mixBits(hash);
+    }
+
+    /**
+     * @brief A function that matches the index in the table to a particular key
+     * @param key Key to index
+     * @return The appropriate index
+     */
+    int _index(const KeyT & key) const
+    {
+        return (int) (_hash(key) & (capacity() - 1));
+    }
+
+    /**
+     * @brief A function that finds the slot of a key (not the sentinel one)
+     * @param key Key to search
+     * @return The index of the key, or of the empty slot that ends its probing
+     */
+    int _find(const KeyT & key) const
+    {
+        int i = _index(key);
+        while (_slots[i].first != key && _slots[i].first != _emptyKey())
+        {
+            i = (i + 1) & (_capacity - 1);
+        }
+        return i;
+    }
+
+    /**
+     * @brief A function that returns the pair stored at a given iterator index
+     * @param i Slot index, or the capacity for the sentinel key pair
+     * @return Reference to the pair
+     */
+    const pairs & _entry(int i) const
+    {
+        return i == _capacity ? _emptyKeyPair : _slots[i];
+    }
+
+public:
+    /**
+     * @brief Default constructor
+     */
+    HashMap() : HashMap(DEF_LOW_FACTOR, DEF_HIGH_FACTOR)
+    {}
+
+    /**
+     * @brief constructor
+     * @param lowFactor Low Load Factor bar
+     * @param higeFactor high Load Factor bar
+     */
+    HashMap(double lowFactor, double higeFactor) : HashMap(lowFactor, higeFactor, Hash())
+    {}
+
+    /**
+     * @brief constructor with a given hash (for example a seeded one)
+     * @param hash The keys hash function
+     */
+    explicit HashMap(const Hash & hash) : HashMap(DEF_LOW_FACTOR, DEF_HIGH_FACTOR, hash)
+    {}
+
+    /**
+     * @brief constructor
+     * @param lowFactor Low Load Factor bar
+     * @param higeFactor high Load Factor bar
+     * @param hash The keys hash function
+     * @param keyEqual The keys comparison (std::equal_to, keys are compared with ==)
+     */
+    HashMap(double lowFactor, double higeFactor, const Hash & hash,
+            const KeyEqual & keyEqual = KeyEqual()) :
+            _capacity(DEF_CAPACITY),
+            _size(DEF_SIZE),
+            _lowLoadFactor(lowFactor),
+            _highLoadFactor(higeFactor),
+            _slots(nullptr),
+            _hasEmptyKey(false),
+            _emptyKeyPair(_emptyKey(), ValueT()),
+            _hashFanc(hash)
+    {
+        static_cast<void>(keyEqual); // Always std::equal_to (checked above)
+        // Input integrity check
+        if (lowFactor <= 0 || lowFactor >= 1 ||
+            higeFactor <= 0 || higeFactor >= 1 ||
+            higeFactor < lowFactor)
+        {
+            throw std::invalid_argument("The resulting arguments are invalid");
+        }
+        _slots = _newSlots(_capacity);
+        _updateBars();
+    }
+
+    /**
+     * @brief Constructor that receives vector keys and vector values and adds them to the map
+     * @param keyVec Vector keys
+     * @param valVec Vector values
+     */
+    HashMap(const std::vector<KeyT> & keyVec, const std::vector<ValueT> & valVec) : HashMap()
+    {
+        // Check that the vectors are the same size
+        if (keyVec.size() != valVec.size())
+        {
+            throw std::invalid_argument("The resulting vectors are not the same size");
+        }
+
+        for (size_t i = 0; i < keyVec.size(); ++i)
+        {
+            (*this)[keyVec[i]] = valVec[i];
+        }
+    }
+
+    /**
+     * @brief Copy Constructor
+     * @param other Map object to copy
+     */
+    HashMap(const HashMap & other) :
+            _capacity(other._capacity),
+            _size(other._size),
+            _lowLoadFactor(other._lowLoadFactor),
+            _highLoadFactor(other._highLoadFactor),
+            _growAt(other._growAt),
+            _shrinkAt(other._shrinkAt),
+            _slots(new pairs[other._capacity]),
+            _hasEmptyKey(other._hasEmptyKey),
+            _emptyKeyPair(other._emptyKeyPair),
+            _hashFanc(other._hashFanc)
+    {
+        for (int i = 0; i < _capacity; ++i)
+        {
+            _slots[i] = other._slots[i];
+        }
+    }
+
+    /**
+     * @brief move Constructor
+     * @param other Map object to move from
+     */
+    HashMap(HashMap && other) noexcept :
+            _capacity(other._capacity),
+            _size(other._size),
+            _lowLoadFactor(other._lowLoadFactor),
+            _highLoadFactor(other._highLoadFactor),
+            _growAt(other._growAt),
+            _shrinkAt(other._shrinkAt),
+            _hasEmptyKey(other._hasEmptyKey),
+            _emptyKeyPair(other._emptyKeyPair),
+            _hashFanc(other._hashFanc)
+    {
+        _slots = other._slots;
+        other._slots = nullptr;
+    }
+
+    /**
+     * @brief destructor
+     */
+    ~HashMap()
+    {
+        delete[] _slots;
+    }
+
+    /**
+     * @brief A function that returns the number of values on the map
+     * @return number of values on the map
+     */
+    int size() const
+    {
+        return _size;
+    }
+
+    /**
+     * @brief A function that returns the map capacity
+     * @return the map capacity
+     */
+    int capacity() const
+    {
+        return _capacity;
+    }
+
+    /**
+     * @brief A function that returns the current load factor
+     * @return the current load factor
+     */
+    double getLoadFactor() const
+    {
+        return ((double) size()) / capacity();
+    }
+
+    /**
+     * @brief Function that returns whether the map is empty
+     * @return true if is empty, false otherwise
+     */
+    bool empty() const
+    {
+        return (size() == DEF_SIZE);
+    }
+
+    /**
+     * @brief A function that adds a new pair to the map
+     * @param key Key to add
+     * @param val Value to add
+     * @return True with the added success, false if not
+     */
+    bool insert(const KeyT & key, const ValueT & val)
+    {
+        if (containsKey(key))
+        {
+            return false;
+        }
+        ++_size;
+        if (_size > _growAt)
+        {
+            _reSize(_capacity * RESIZE_PARM);
+        }
+        if (key == _emptyKey())
+        {
+            _hasEmptyKey = true;
+            _emptyKeyPair.second = val;
+            return true;
+        }
+        _slots[_find(key)] = std::make_pair(key, val);
+        return true;
+    }
+
+    /**
+     * @brief A function that checks whether a particular key exists on the map
+     * @param key key to chack
+     * @return true if it exists, false if not
+     */
+    bool containsKey(const KeyT & key) const
+    {
+        if (key == _emptyKey())
+        {
+            return _hasEmptyKey;
+        }
+        return _slots[_find(key)].first == key;
+    }
+
+    /**
+     * @brief A function that returns a value by a particular key if it is on the map
+     * @param keyToSearch A key to look for on the map
+     * @return Reference the correct value (can be inserted into it)
+     */
+    ValueT & at(const KeyT & keyToSearch)
+    {
+        return const_cast<ValueT &>(static_cast<const HashMap &>(*this).at(keyToSearch));
+    }
+
+    /**
+     * @brief A function that returns a value by a particular key if it is on the map
+     * @param keyToSearch A key to look for on the map
+     * @return const Reference the correct value (can't be inserted into it)
+     */
+    const ValueT & at(const KeyT & keyToSearch) const
+    {
+        if (keyToSearch == _emptyKey())
+        {
+            if (_hasEmptyKey)
+            {
+                return _emptyKeyPair.second;
+            }
+        }
+        else
+        {
+            int i = _find(keyToSearch);
+            if (_slots[i].first == keyToSearch)
+            {
+                return _slots[i].second;
+            }
+        }
+        throw std::out_of_range("The key does not exist on the map");
+    }
+
+    /**
+     * @brief A function that deletes a pair from the map, by a specific key
+     * @param ketToDel Key to delete
+     * @return false if the deletion was successful, otherwise false
+     */
+    bool erase(const KeyT & ketToDel)
+    {
+        if (ketToDel == _emptyKey())
+        {
+            if (!_hasEmptyKey)
+            {
+                return false;
+            }
+            _hasEmptyKey = false;
+            _emptyKeyPair.second = ValueT();
+        }
+        else
+        {
+            int hole = _find(ketToDel);
+            if (_slots[hole].first != ketToDel)
+            {
+                return false;
+            }
+            // Backward shift - pull back every following pair that may be placed in the hole
+            const int mask = _capacity - 1;
+            for (int j = (hole + 1) & mask; _slots[j].first != _emptyKey(); j = (j + 1) & mask)
+            {
+                int home = _index(_slots[j].first);
+                if (((j - home) & mask) >= ((j - hole) & mask))
+                {
+                    _slots[hole] = _slots[j];
+                    hole = j;
+                }
+            }
+            _slots[hole] = std::make_pair(_emptyKey(), ValueT());
+        }
+        --_size;
+        if (_size < _shrinkAt)
+        {
+            _reSize(_capacity / RESIZE_PARM);
+        }
+        return true;
+    }
+
+    /**
+     * @brief  function that returns the basket size to a specific key - in this table it is the
+     *          number of slots probed until the key is found
+     * @param key Search key
+     * @return basket size to a specific key
+     */
+    int bucketSize(const KeyT & key) const
+    {
+        if (!containsKey(key))
+        {
+            throw std::out_of_range("The key does not exist on the map");
+        }
+        if (key == _emptyKey())
+        {
+            return 1;
+        }
+        return ((_find(key) - _index(key)) & (_capacity - 1)) + 1;
+    }
+
+    /**
+     * @brief A function that returns the memory used by the map
+     * @return the memory used by the map (the pairs are inline in the table)
+     */
+    MemoryUsage memoryUsage() const
+    {
+        return {sizeof(*this) + _capacity * sizeof(pairs), 0, 0, 0};
+    }
+
+    /**
+     * @brief A function that shrinks the map to the smallest table that keeps the high load
+     *        factor (the pairs are already inline in the table)
+     */
+    void shrinkToFit()
+    {
+        int newCap = MIN_CAPACITY;
+        while (size() > _highLoadFactor * newCap)
+        {
+            newCap *= RESIZE_PARM;
+        }
+        _reSize(newCap);
+    }
+
+    /**
+     * @brief A function that deletes all values on the map
+     */
+    void clear()
+    {
+        for (int i = 0; i < _capacity; ++i)
+        {
+            _slots[i] = std::make_pair(_emptyKey(), ValueT());
+        }
+        _hasEmptyKey = false;
+        _emptyKeyPair.second = ValueT();
+        _size = 0;
+    }
+
+    /**
+     * @brief Placement Operator
+     * @param other Map object to copy
+     * @return Reference to the object itself
+     */
+    HashMap & operator=(const HashMap & other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        delete[] _slots;
+        _capacity = other._capacity;
+        _size = other._size;
+        _lowLoadFactor = other._lowLoadFactor;
+        _highLoadFactor = other._highLoadFactor;
+        _growAt = other._growAt;
+        _shrinkAt = other._shrinkAt;
+        _hasEmptyKey = other._hasEmptyKey;
+        _emptyKeyPair = other._emptyKeyPair;
+        _hashFanc = other._hashFanc;
+        _slots = new pairs[other._capacity];
+
+        for (int i = 0; i < _capacity; ++i)
+        {
+            _slots[i] = other._slots[i];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Operator Value Access by Key
+     * @param key A key to accessing its value
+     * @return Reference to the appropriate value
+     */
+    ValueT & operator[](const KeyT & key)
+    {
+        insert(key, ValueT());
+        return at(key);
+    }
+
+    /**
+     * @brief Operator Value Access by Key
+     * @param key A key to accessing its value
+     * @return const Reference to the appropriate value (out_of_range if the key is missing)
+     */
+    const ValueT & operator[](const KeyT & key) const
+    {
+        return at(key);
+    }
+
+    /**
+     * @brief Comparison operator
+     * @param other Map object for comparison
+     * @return True if the objects are equal, false otherwise
+     */
+    bool operator==(const HashMap & other) const
+    {
+        if (size() != other.size() || capacity() != other.capacity())
+        {
+            return false;
+        }
+        for (auto & pair : *this)
+        {
+            if (!other.containsKey(pair.first) || other.at(pair.first) != pair.second)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief ancomparison operator
+     * @param other Map object for comparison
+     * @return False if the objects are equal, otherwise true
+     */
+    bool operator!=(const HashMap & other) const
+    {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief A constant iterator on the map values - runs over the slots, and then over the
+     *        sentinel key pair (at index capacity)
+     */
+    class const_iterator
+    {
+    private:
+        /**   Pointer to the map object          */
+        const HashMap *_myMap;
+        /**   The current slot index      */
+        int _slotIndex;
+
+    public:
+        /**
+         * @brief Default constructor - to start map
+         * @param myMap Pointer to the map object
+         */
+        explicit const_iterator(const HashMap *myMap) :
+                _myMap(myMap),
+                _slotIndex(INIT_LIST_INDEX)
+        {
+            operator++(); // Looking for the first object
+        }
+
+        /**
+         * @brief constructor - Index to the beginning of the iterator
+         * @param slotI Initial slot index
+         * @param myMap Pointer to the map object
+         */
+        const_iterator(int slotI, const HashMap *myMap) :
+                _myMap(myMap),
+                _slotIndex(slotI)
+        {}
+
+        /**
+         * @brief Access operator asterisk
+         * @return A reference to the appropriate pair for the iterator
+         */
+        const std::pair<KeyT, ValueT> & operator*() const
+        {
+            return _myMap->_entry(_slotIndex);
+        }
+
+        /**
+         * @brief Access operator arrow
+         * @return Pointer to the appropriate pair
+         */
+        const std::pair<KeyT, ValueT> *operator->() const
+        {
+            return &_myMap->_entry(_slotIndex);
+        }
+
+        /**
+         * @brief Progress operator
+         * @return Pointer to the iterator object
+         */
+        const_iterator & operator++()
+        {
+            while (++_slotIndex < _myMap->capacity() &&
+                   _myMap->_slots[_slotIndex].first == _emptyKey())
+            {}
+            if (_slotIndex == _myMap->capacity() && !_myMap->_hasEmptyKey)
+            {
+                ++_slotIndex;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Progress operator
+         * @return iterator object
+         */
+        const_iterator operator++(int)
+        {
+            const_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        /**
+         * @brief Comparison operator
+         * @param rhs Another iterator object
+         * @return True if they are equal, false otherwise
+         */
+        bool operator==(const_iterator const & rhs) const
+        {
+            return _myMap == rhs._myMap && _slotIndex == rhs._slotIndex;
+        }
+
+        /**
+         * @brief Comparison operator
+         * @param rhs Another iterator object
+         * @return false if they are equal, true otherwise
+         */
+        bool operator!=(const_iterator const & rhs) const
+        {
+            return !(*this == rhs);
+        }
+    };
+
+    /**
+     * @brief A function that returns a directed iterator to the beginning of the map
+     * @return iterator to the beginning of the map
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(this);
+    }
+
+    /**
+     * @brief A function that returns an iterator directed to the end of the map
+     * @return iterator directed to the end of the map
+     */
+    const_iterator end() const
+    {
+        return const_iterator(capacity() + 1, this);
+    }
+
+    /**
+     * @brief A function that returns a directed iterator to the beginning of the map
+     * @return iterator to the beginning of the map
+     */
+    const_iterator cbegin() const
+    {
+        return const_iterator(this);
+    }
+
+    /**
+     * @brief A function that returns an iterator directed to the end of the map
+     * @return iterator directed to the end of the map
+     */
+    const_iterator cend() const
+    {
+        return const_iterator(capacity() + 1, this);
+    }
+};
+
 #endif //CPP_EX3_HASHMAP_HPP
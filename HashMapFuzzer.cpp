@@ -0,0 +1,596 @@
+/**
+ * Differential fuzzer of the map engines and of the spam scanner.
+ * Every input is a sequence of operations, replayed on a map and on std::unordered_map (or, for
+ * the scanner, compared with a naive search). The first byte of the input selects the engine.
+ * --bench replays only the point operations (insert, erase, containsKey, at, operator[]) without
+ * the reference, and reports operations per second - the whole map operations (copy,
+ * shrinkToFit, the vectors constructor, compare) run only when fuzzing and in --random.
+ *
+ * libFuzzer:
+ *     clang++ -std=c++14 -g -O1 -DLIBFUZZER -fsanitize=fuzzer,address,undefined \
+ *         HashMapFuzzer.cpp SpamDetector.cpp -o HashMapFuzzer
+ *     ./HashMapFuzzer corpus/
+ * AFL (input from a file, or from stdin without arguments):
+ *     afl-clang-fast++ -std=c++14 -g -fsanitize=address,undefined \
+ *         HashMapFuzzer.cpp SpamDetector.cpp -o HashMapFuzzer
+ *     afl-fuzz -i seeds -o findings -- ./HashMapFuzzer @@
+ * Random differential run / point operations benchmark of every engine:
+ *     g++ -std=c++14 -O2 HashMapFuzzer.cpp SpamDetector.cpp -o HashMapFuzzer
+ *     ./HashMapFuzzer --random 10000
+ *     ./HashMapFuzzer --bench 10000
+ */
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "HashMap.hpp"
+#include "SmallString.hpp"
+#include "SpamDetector.hpp"
+
+/**   The engines an input can select        */
+enum Engine
+{
+    GENERIC_STRING, GENERIC_INT, FLAT_INT, SMALL_STRING, SEEDED_STRING, SEEDED_INT, SCANNER,
+    NUM_OF_ENGINES
+};
+const char *const ENGINE_NAMES[NUM_OF_ENGINES] = {"generic string", "generic int", "flat int",
+                                                  "SmallString", "seeded string", "seeded int",
+                                                  "scanner"};
+
+/**   Load factors an input can select - the first are the defaults (of the seeded engines),
+ *    the last ones are invalid        */
+const double LOAD_FACTORS[][2] = {{0.25, 0.75}, {0.1, 0.9}, {0.5, 0.55}, {0.6, 0.99},
+                                  {0.01, 0.02}, {0.5, 0.4}, {0, 0.5}, {0.5, 1}};
+const int NUM_OF_FACTORS = 8;
+const int NUM_OF_VALID_FACTORS = 5;
+
+/**   Map operations - the first ones are the point operations of --bench        */
+const int NUM_OF_OPS = 10;
+const int NUM_OF_POINT_OPS = 5;
+/**   Generated keys and texts use a small alphabet, to get collisions and matches        */
+const std::string ALPHABET = "abAB x,\n";
+/**   Longest generated string key (longer than the inline buffers)        */
+const int MAX_KEY_LEN = 40;
+/**   Longest generated phrase and number of phrases of the scanner        */
+const int MAX_PHRASE_LEN = 6;
+const int MAX_PHRASES = 12;
+/**   Largest generated value        */
+const int MAX_VALUE = 100;
+
+/**   Size of the random inputs of --random and --bench        */
+const size_t RANDOM_INPUT_SIZE = 4096;
+const int DEF_ROUNDS = 1000;
+
+
+/**
+ * @brief Reads the fuzzer input - zeros after its end
+ */
+class Reader
+{
+private:
+    /**   The input         */
+    const std::uint8_t *_data;
+    /**   The input size         */
+    size_t _size;
+    /**   The current position         */
+    size_t _pos;
+
+public:
+    /**
+     * @brief constructor
+     * @param data The input
+     * @param size The input size
+     */
+    Reader(const std::uint8_t *data, size_t size) : _data(data), _size(size), _pos(0)
+    {}
+
+    /**
+     * @brief Function that returns whether the whole input was read
+     * @return true if it was, false otherwise
+     */
+    bool done() const
+    {
+        return _pos >= _size;
+    }
+
+    /**
+     * @brief A function that reads a byte
+     * @return the next byte
+     */
+    std::uint8_t byte()
+    {
+        return _pos < _size ? _data[_pos++] : 0;
+    }
+
+    /**
+     * @brief A function that reads 4 bytes
+     * @return the next 4 bytes
+     */
+    std::uint32_t word()
+    {
+        std::uint32_t w = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            w = (w << 8) | byte();
+        }
+        return w;
+    }
+
+    /**
+     * @brief A function that reads a string over the alphabet
+     * @param len The string length
+     * @return the string
+     */
+    std::string text(size_t len)
+    {
+        std::string str;
+        for (size_t i = 0; i < len; ++i)
+        {
+            str += ALPHABET[byte() % ALPHABET.size()];
+        }
+        return str;
+    }
+};
+
+/**
+ * @brief Stops the run on a difference from the reference
+ * @param cond The checked condition
+ * @param what Description of the check
+ */
+void check(bool cond, const char *what)
+{
+    if (!cond)
+    {
+        std::cerr << "Mismatch: " << what << std::endl;
+        std::abort();
+    }
+}
+
+/**
+ * @brief Generates a key of the reference map - mostly few small numbers, sometimes the flat
+ *        map sentinel or any number
+ * @param r The input
+ * @param key The generated key
+ */
+void makeKey(Reader & r, int & key)
+{
+    switch (r.byte() % 4)
+    {
+        case 0:
+            key = std::numeric_limits<int>::max();
+            break;
+        case 1:
+            key = (int) r.word();
+            break;
+        default:
+            key = (int) (r.byte() % 64) - 32;
+    }
+}
+
+/**
+ * @brief Generates a key of the reference map - strings around the SSO and SmallString limits
+ * @param r The input
+ * @param key The generated key
+ */
+void makeKey(Reader & r, std::string & key)
+{
+    key = r.text(r.byte() % (MAX_KEY_LEN + 1));
+    if (r.byte() % 2 == 0)
+    {
+        key.resize(key.size() % 3); // Few short keys, to get repeats
+    }
+}
+
+/**
+ * @brief Converts a map key to a reference map key
+ * @param key The map key
+ * @return The same key
+ */
+int toRef(int key)
+{
+    return key;
+}
+
+/**
+ * @brief Converts a map key to a reference map key
+ * @param key The map key
+ * @return The same key
+ */
+std::string toRef(const std::string & key)
+{
+    return key;
+}
+
+/**
+ * @brief Converts a map key to a reference map key
+ * @param key The map key
+ * @return The key as std::string
+ */
+std::string toRef(const SmallString & key)
+{
+    return key.str();
+}
+
+/**
+ * @brief Compares the whole map with the reference
+ * @param map The map
+ * @param ref The reference map
+ */
+template<class Map, class RefKeyT>
+void compare(const Map & map, const std::unordered_map<RefKeyT, int> & ref)
+{
+    check(map.size() == (int) ref.size(), "size");
+    check(map.empty() == ref.empty(), "empty");
+    size_t count = 0;
+    for (auto & pair : map)
+    {
+        auto found = ref.find(toRef(pair.first));
+        check(found != ref.end() && found->second == pair.second, "iterated pair");
+        ++count;
+    }
+    check(count == ref.size(), "iterated count");
+    count = 0;
+    for (auto itr = map.cbegin(); itr != map.cend(); itr++)
+    {
+        check(map.containsKey(itr->first), "iterated key lookup");
+        ++count;
+    }
+    check(count == ref.size(), "const iterated count");
+    for (auto & pair : ref)
+    {
+        check(map.containsKey(pair.first) && map.at(pair.first) == pair.second, "reference pair");
+    }
+}
+
+/**
+ * @brief Replays the input operations on a map (and on the reference map, when verified)
+ * @tparam Map The map type
+ * @tparam KeyT The map key type
+ * @tparam RefKeyT The reference key type
+ * @param r The input
+ * @param verify Whether to compare with the reference map, false to time the point operations
+ * @param seeded Whether to build the map with a hash seed from the input (and the default load
+ *               factors) instead of load factors from the input
+ * @return Number of replayed operations
+ */
+template<class Map, class KeyT, class RefKeyT>
+long runMap(Reader & r, bool verify, bool seeded = false)
+{
+    int factors = 0;
+    std::uint64_t seed = 0;
+    if (seeded)
+    {
+        seed = ((std::uint64_t) r.word() << 32) | r.word();
+    }
+    else
+    {
+        factors = r.byte() % NUM_OF_FACTORS;
+    }
+    double low = LOAD_FACTORS[factors][0], high = LOAD_FACTORS[factors][1];
+    try
+    {
+        Map probe(low, high);
+        check(factors < NUM_OF_VALID_FACTORS, "valid load factors");
+    }
+    catch (std::invalid_argument & e)
+    {
+        check(factors >= NUM_OF_VALID_FACTORS, "invalid load factors");
+        return 0;
+    }
+
+    Map map = seeded ? Map(FastHash<KeyT>(seed)) : Map(low, high);
+    std::unordered_map<RefKeyT, int> ref;
+    long numOfOps = 0;
+    for (; !r.done(); ++numOfOps)
+    {
+        int op = r.byte() % (verify ? NUM_OF_OPS : NUM_OF_POINT_OPS);
+        RefKeyT refKey;
+        makeKey(r, refKey);
+        const KeyT key(refKey);
+        int val = r.byte() % MAX_VALUE;
+        const Map & constMap = map;
+
+        switch (op)
+        {
+            case 0:
+            case 1:
+            {
+                bool added = map.insert(key, val);
+                if (verify)
+                {
+                    check(added == ref.emplace(refKey, val).second, "insert");
+                }
+                break;
+            }
+            case 2:
+            {
+                bool erased = map.erase(key);
+                if (verify)
+                {
+                    check(erased == (ref.erase(refKey) == 1), "erase");
+                }
+                break;
+            }
+            case 3:
+                if (map.containsKey(key))
+                {
+                    check(map.at(key) == constMap[key] && map.bucketSize(key) >= 1, "lookup");
+                    if (verify)
+                    {
+                        check(ref.count(refKey) == 1 && ref[refKey] == map.at(key), "lookup");
+                    }
+                }
+                else if (verify)
+                {
+                    bool thrown = false;
+                    try
+                    {
+                        constMap[key];
+                    }
+                    catch (std::out_of_range & e)
+                    {
+                        thrown = true;
+                    }
+                    check(thrown, "const operator[] of a missing key");
+                    check(ref.count(refKey) == 0, "missing key");
+                }
+                break;
+            case 4:
+                map[key] += val;
+                if (verify)
+                {
+                    ref[refKey] += val;
+                }
+                break;
+            case 5:
+                if (val == 0)
+                {
+                    map.clear();
+                    ref.clear();
+                }
+                break;
+            case 6:
+            {
+                Map copy(map);
+                check(copy == map, "copy");
+                Map assigned;
+                assigned = copy;
+                check(assigned == map && !(assigned != map), "assignment");
+                Map moved(std::move(copy));
+                check(moved == map, "move");
+                break;
+            }
+            case 7:
+                map.shrinkToFit();
+                check(map.empty() || map.getLoadFactor() <= high, "shrinkToFit load factor");
+                check(map.memoryUsage().total() >= sizeof(map), "memoryUsage");
+                break;
+            case 8:
+            {
+                std::vector<KeyT> keys;
+                std::vector<int> values;
+                for (auto & pair : map)
+                {
+                    keys.push_back(pair.first);
+                    values.push_back(pair.second);
+                }
+                Map built(keys, values);
+                check(built.size() == map.size(), "vectors constructor");
+                values.push_back(val);
+                bool thrown = false;
+                try
+                {
+                    Map mismatched(keys, values);
+                }
+                catch (std::invalid_argument & e)
+                {
+                    thrown = true;
+                }
+                check(thrown, "vectors of different sizes");
+                break;
+            }
+            default:
+                if (verify)
+                {
+                    compare(map, ref);
+                }
+        }
+        if (verify)
+        {
+            check(map.size() == (int) ref.size(), "size");
+        }
+    }
+    if (verify)
+    {
+        compare(map, ref);
+    }
+    return numOfOps;
+}
+
+/**
+ * @brief Builds a phrases database from the input (compacted by shrinkToFit when the input says
+ *        so, as getData does) and scores a text with the scanner, compared with a naive search
+ * @param r The input
+ * @param verify Whether to compare with the naive search
+ */
+void runScanner(Reader & r, bool verify)
+{
+    HashMap<SmallString, int> dataBase;
+    std::vector<std::pair<std::string, int>> phrases;
+    int numOfPhrases = r.byte() % MAX_PHRASES + 1;
+    for (int i = 0; i < numOfPhrases; ++i)
+    {
+        std::string phrase = r.text(r.byte() % MAX_PHRASE_LEN + 1);
+        for (auto & c : phrase)
+        { c = toupper(c); }
+        int score = r.byte() % MAX_VALUE;
+        if (dataBase.insert(phrase, score))
+        {
+            phrases.emplace_back(phrase, score);
+        }
+    }
+    if (r.byte() % 2 == 0)
+    {
+        dataBase.shrinkToFit();
+    }
+    std::string text;
+    while (!r.done())
+    {
+        text += r.text(1);
+    }
+
+    std::istringstream mail(text);
+    int sum = searchInStream(mail, dataBase);
+    if (!verify)
+    {
+        return;
+    }
+
+    // Naive search - every phrase at every position of every line
+    int expected = 0;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        for (auto & c : line)
+        { c = toupper(c); }
+        for (auto & phrase : phrases)
+        {
+            for (size_t pos = 0; pos + phrase.first.size() <= line.size(); ++pos)
+            {
+                if (std::equal(phrase.first.begin(), phrase.first.end(), line.begin() + pos))
+                {
+                    expected += phrase.second;
+                }
+            }
+        }
+    }
+    check(sum == expected, "scanner score");
+}
+
+/**
+ * @brief Runs one input on the engine it selects
+ * @param data The input
+ * @param size The input size
+ * @param verify Whether to compare with the reference
+ * @return Number of replayed map operations (0 for the scanner)
+ */
+long runInput(const std::uint8_t *data, size_t size, bool verify)
+{
+    Reader r(data, size);
+    switch (r.byte() % NUM_OF_ENGINES)
+    {
+        case GENERIC_STRING:
+            return runMap<HashMap<std::string, int>, std::string, std::string>(r, verify);
+        case GENERIC_INT:
+            return runMap<HashMap<int, int, FastHash<int>, std::equal_to<int>, false>, int, int>(
+                    r, verify);
+        case FLAT_INT:
+            return runMap<HashMap<int, int>, int, int>(r, verify);
+        case SMALL_STRING:
+            return runMap<HashMap<SmallString, int>, SmallString, std::string>(r, verify);
+        case SEEDED_STRING:
+            return runMap<HashMap<std::string, int>, std::string, std::string>(r, verify, true);
+        case SEEDED_INT:
+            return runMap<HashMap<int, int>, int, int>(r, verify, true);
+        default:
+            runScanner(r, verify);
+            return 0;
+    }
+}
+
+/**
+ * @brief libFuzzer entry point
+ * @param data The input
+ * @param size The input size
+ * @return 0
+ */
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, size_t size)
+{
+    runInput(data, size, true);
+    return 0;
+}
+
+#ifndef LIBFUZZER
+
+/**
+ * @brief Runs random inputs on every engine, and prints the throughput of each one (map
+ *        operations per second, and input bytes per second)
+ * @param rounds Number of inputs to each engine
+ * @param verify Whether to compare with the reference (--random) or only time the point
+ *               operations (--bench)
+ */
+void runRandom(int rounds, bool verify)
+{
+    std::mt19937 gen(rounds);
+    for (int engine = 0; engine < NUM_OF_ENGINES; ++engine)
+    {
+        // Generated before the timing, so that only the replay is measured
+        std::vector<std::vector<std::uint8_t>> inputs(rounds,
+                                                      std::vector<std::uint8_t>(RANDOM_INPUT_SIZE));
+        for (auto & data : inputs)
+        {
+            std::generate(data.begin(), data.end(), std::ref(gen));
+            data[0] = (std::uint8_t) engine;
+        }
+        long numOfOps = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (auto & data : inputs)
+        {
+            numOfOps += runInput(data.data(), data.size(), verify);
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                .count();
+        std::cout << ENGINE_NAMES[engine] << ": " << rounds << " inputs, ";
+        if (numOfOps > 0)
+        {
+            std::cout << numOfOps / secs / 1e6 << " Mops/s, ";
+        }
+        std::cout << (rounds * RANDOM_INPUT_SIZE) / secs / (1 << 20) << " MB/s" << std::endl;
+    }
+}
+
+/**
+ * @brief Replays input files (or stdin), or runs random inputs
+ * @param argc Number of arguments
+ * @param argv The argument vector
+ * @return 0 If every input passed (a mismatch aborts)
+ */
+int main(int argc, const char *argv[])
+{
+    if (argc >= 2 && (std::string(argv[1]) == "--random" || std::string(argv[1]) == "--bench"))
+    {
+        runRandom(argc >= 3 ? std::atoi(argv[2]) : DEF_ROUNDS, std::string(argv[1]) == "--random");
+        return EXIT_SUCCESS;
+    }
+
+    std::vector<std::string> inputs;
+    if (argc < 2)
+    {
+        inputs.emplace_back(std::istreambuf_iterator<char>(std::cin),
+                            std::istreambuf_iterator<char>());
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        std::ifstream file(argv[i], std::ios::binary);
+        inputs.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    for (auto & input : inputs)
+    {
+        runInput((const std::uint8_t *) input.data(), input.size(), true);
+    }
+    return EXIT_SUCCESS;
+}
+
+#endif //LIBFUZZER
@@ -0,0 +1,262 @@
+#ifndef CPP_EX3_SMALLSTRING_HPP
+#define CPP_EX3_SMALLSTRING_HPP
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include "HashMap.hpp"
+
+/**  Size of the object - never bigger than std::string  */
+const std::size_t SMALL_STRING_BYTES = sizeof(std::string);
+/**  Number of characters kept inside the object, without a heap allocation  */
+const std::size_t INLINE_CAPACITY = SMALL_STRING_BYTES - 1;
+/**  Tag byte value of a string on the heap (inline tags are 0 to INLINE_CAPACITY)  */
+const unsigned char HEAP_TAG = 0xFF;
+
+
+/**
+ * @brief A string for map keys - strings of up to INLINE_CAPACITY characters (most phrases) are
+ *        kept inside the object, longer ones in a single heap allocation. The last byte of the
+ *        object is a tag: INLINE_CAPACITY minus the length for inline strings (so a full inline
+ *        string ends with the null terminator), or HEAP_TAG.
+ */
+class SmallString
+{
+private:
+    /**   The heap string - pointer and length         */
+    struct HeapStr
+    {
+        /**   The characters         */
+        char *ptr;
+        /**   Number of characters         */
+        std::size_t size;
+    };
+
+    /**   The storage - inline characters and tag, or the heap string (and the tag)         */
+    union
+    {
+        char _inline[SMALL_STRING_BYTES];
+        HeapStr _heap;
+    };
+
+    /**
+     * @brief Function that returns whether the characters are on the heap
+     * @return true if they are, false otherwise
+     */
+    bool _onHeap() const
+    {
+        return (unsigned char) _inline[INLINE_CAPACITY] == HEAP_TAG;
+    }
+
+    /**
+     * @brief A function that copies characters into an uninitialized object
+     * @param str The characters
+     * @param len Number of characters
+     */
+    void _assign(const char *str, std::size_t len)
+    {
+        if (len > INLINE_CAPACITY)
+        {
+            char *ptr = new char[len + 1];
+            std::memcpy(ptr, str, len);
+            ptr[len] = '\0';
+            _heap.ptr = ptr;
+            _heap.size = len;
+            _inline[INLINE_CAPACITY] = (char) HEAP_TAG;
+            return;
+        }
+        std::memcpy(_inline, str, len);
+        _inline[len] = '\0';
+        _inline[INLINE_CAPACITY] = (char) (INLINE_CAPACITY - len);
+    }
+
+public:
+    /**
+     * @brief Default constructor - empty string
+     */
+    SmallString()
+    {
+        _assign("", 0);
+    }
+
+    /**
+     * @brief constructor (implicit, so that a map of SmallString accepts std::string keys)
+     * @param str String to copy
+     */
+    SmallString(const std::string & str)
+    {
+        _assign(str.data(), str.size());
+    }
+
+    /**
+     * @brief constructor (implicit, so that a map of SmallString accepts literal keys)
+     * @param str Null terminated string to copy
+     */
+    SmallString(const char *str)
+    {
+        _assign(str, std::strlen(str));
+    }
+
+    /**
+     * @brief Copy Constructor
+     * @param other String to copy
+     */
+    SmallString(const SmallString & other)
+    {
+        _assign(other.data(), other.size());
+    }
+
+    /**
+     * @brief move Constructor
+     * @param other String to move from
+     */
+    SmallString(SmallString && other) noexcept
+    {
+        std::memcpy(_inline, other._inline, SMALL_STRING_BYTES);
+        other._assign("", 0);
+    }
+
+    /**
+     * @brief destructor
+     */
+    ~SmallString()
+    {
+        if (_onHeap())
+        {
+            delete[] _heap.ptr;
+        }
+    }
+
+    /**
+     * @brief Placement Operator
+     * @param other String to copy
+     * @return Reference to the object itself
+     */
+    SmallString & operator=(const SmallString & other)
+    {
+        SmallString tmp(other);
+        return *this = std::move(tmp);
+    }
+
+    /**
+     * @brief move Placement Operator
+     * @param other String to move from
+     * @return Reference to the object itself
+     */
+    SmallString & operator=(SmallString && other) noexcept
+    {
+        char tmp[SMALL_STRING_BYTES];
+        std::memcpy(tmp, _inline, SMALL_STRING_BYTES);
+        std::memcpy(_inline, other._inline, SMALL_STRING_BYTES);
+        std::memcpy(other._inline, tmp, SMALL_STRING_BYTES);
+        return *this;
+    }
+
+    /**
+     * @brief A function that returns the characters
+     * @return Pointer to the null terminated characters
+     */
+    const char *data() const
+    {
+        return _onHeap() ? _heap.ptr : _inline;
+    }
+
+    /**
+     * @brief A function that returns the number of characters
+     * @return number of characters
+     */
+    std::size_t size() const
+    {
+        return _onHeap() ? _heap.size : INLINE_CAPACITY - (unsigned char) _inline[INLINE_CAPACITY];
+    }
+
+    /**
+     * @brief A function that returns the heap bytes owned by the string
+     * @return 0 for inline strings, the allocation size otherwise
+     */
+    std::size_t heapBytes() const
+    {
+        return _onHeap() ? _heap.size + 1 : 0;
+    }
+
+    /**
+     * @brief A function that converts the string to std::string
+     * @return std::string with the same characters
+     */
+    std::string str() const
+    {
+        return std::string(data(), size());
+    }
+
+    /**
+     * @brief Comparison operator
+     * @param other String for comparison
+     * @return True if the strings are equal, false otherwise
+     */
+    bool operator==(const SmallString & other) const
+    {
+        return size() == other.size() && std::memcmp(data(), other.data(), size()) == 0;
+    }
+
+    /**
+     * @brief ancomparison operator
+     * @param other String for comparison
+     * @return False if the strings are equal, otherwise true
+     */
+    bool operator!=(const SmallString & other) const
+    {
+        return !(*this == other);
+    }
+};
+
+static_assert(sizeof(SmallString) == SMALL_STRING_BYTES, "SmallString is bigger than std::string");
+static_assert(sizeof(char *) + sizeof(std::size_t) < SMALL_STRING_BYTES,
+              "The heap string overlaps the tag byte");
+
+/**
+ * @brief The default hash of SmallString - wyhash, as for std::string
+ */
+template<>
+class FastHash<SmallString>
+{
+private:
+    /**   The seed of this hash         */
+    std::uint64_t _seed;
+
+public:
+    /**
+     * @brief constructor
+     * @param seed The seed of this hash
+     */
+    explicit FastHash(std::uint64_t seed = 0) : _seed(seed)
+    {}
+
+    /**
+     * @brief Hash operator
+     * @param key Key to hash
+     * @return The hash value
+     */
+    std::size_t operator()(const SmallString & key) const
+    {
+        return (std::size_t) wyHash(key.data(), key.size(), _seed);
+    }
+};
+
+/**
+ * @brief Heap bytes owned by a SmallString
+ */
+template<>
+struct HeapBytes<SmallString>
+{
+    /**
+     * @brief Heap bytes operator
+     * @param str The string
+     * @return number of heap bytes owned by the string
+     */
+    std::size_t operator()(const SmallString & str) const
+    {
+        return str.heapBytes();
+    }
+};
+
+#endif //CPP_EX3_SMALLSTRING_HPP
@@ -1,6 +1,6 @@
 #include <iostream>
 #include <fstream>
-#include "HashMap.hpp"
+#include "SpamDetector.hpp"
 
 /**   The number of valid parameters        */
 const int NUM_OF_PARM = 4;
@@ -22,7 +22,7 @@ const std::string NOT_SPAM_MSG = "NOT_SPAM";
  * @param filePath Path to the information file
  * @param dataBase database object to fill
  */
-void getData(const char *filePath, HashMap<std::string, int> & dataBase)
+void getData(const char *filePath, HashMap<SmallString, int> & dataBase)
 {
     // Open the file
     std::ifstream dataBaseFile;
@@ -53,6 +53,7 @@ void getData(const char *filePath, HashMap<std::string, int> & dataBase)
         dataBase.insert(line, num);
     }
     dataBaseFile.close();
+    dataBase.shrinkToFit(); // The database is only read from now on
 }
 
 /**
@@ -61,7 +62,7 @@ void getData(const char *filePath, HashMap<std::string, int> & dataBase)
  * @param dataBase The database of suspected sentences
  * @return The number of bad points in the file
  */
-int searchInFile(const char *pathToFile, const HashMap<std::string, int> & dataBase)
+int searchInFile(const char *pathToFile, const HashMap<SmallString, int> & dataBase)
 {
     // Open the file
     std::ifstream mailFile;
@@ -71,27 +72,39 @@ int searchInFile(const char *pathToFile, const HashMap<std::string, int> & dataB
         throw std::ifstream::failure("Unable to open file");
     }
 
+    int sum = searchInStream(mailFile, dataBase);
+    mailFile.close();
+    return sum;
+}
+
+/**
+ * @brief Search the suspicious phrases in the given text
+ * @param mail The text stream
+ * @param dataBase The database of suspected sentences
+ * @return The number of bad points in the text
+ */
+int searchInStream(std::istream & mail, const HashMap<SmallString, int> & dataBase)
+{
     int sum = EMPTY;
     std::string line;
 
-    // Browse the entire file by rows
-    while (!mailFile.eof())
+    // Browse the entire text by rows
+    while (!mail.eof())
     {
-        getline(mailFile, line);
+        getline(mail, line);
         for (auto & c: line)
         { c = toupper(c); } // Convert to capital letters
         // Search all sentences in the database in a row
         for (auto & pair : dataBase)
         {
             size_t pos = EMPTY;
-            while ((pos = line.find(pair.first, pos)) != std::string::npos)
+            while ((pos = line.find(pair.first.data(), pos, pair.first.size())) != std::string::npos)
             {
                 sum += pair.second;
                 pos++;
             }
         }
     }
-    mailFile.close();
     return sum;
 }
 
@@ -111,7 +124,7 @@ int main2(int argc, const char *argv[])
     }
 
     std::string limitStr(argv[3]);
-    HashMap<std::string, int> database;
+    HashMap<SmallString, int> database;
     try
     {
         // Receiving information from the files
@@ -0,0 +1,32 @@
+#ifndef CPP_EX3_SPAMDETECTOR_HPP
+#define CPP_EX3_SPAMDETECTOR_HPP
+
+#include <istream>
+#include "HashMap.hpp"
+#include "SmallString.hpp"
+
+/**
+ * @brief function that parses the corresponding sentence and number file and stores it in data map
+ * @param filePath Path to the information file
+ * @param dataBase database object to fill
+ */
+void getData(const char *filePath, HashMap<SmallString, int> & dataBase);
+
+/**
+ * @brief Search the suspicious phrases in the given text file
+ * @param pathToFile Path to the text file
+ * @param dataBase The database of suspected sentences
+ * @return The number of bad points in the file
+ */
+int searchInFile(const char *pathToFile, const HashMap<SmallString, int> & dataBase);
+
+/**
+ * @brief Search the suspicious phrases in the given text (the database phrases are in capital
+ *        letters, the text is converted line by line)
+ * @param mail The text stream
+ * @param dataBase The database of suspected sentences
+ * @return The number of bad points in the text
+ */
+int searchInStream(std::istream & mail, const HashMap<SmallString, int> & dataBase);
+
+#endif //CPP_EX3_SPAMDETECTOR_HPP